@@ -9,10 +9,30 @@ CONF_UNIT_ID = "unit_id"
 CONF_WATCHDOG_REGISTER = "watchdog_register"
 CONF_WATCHDOG_INTERVAL = "watchdog_interval"
 CONF_SAFE_MODE_REGISTERS = "safe_mode_registers"
+CONF_TRANSPORT = "transport"
+CONF_RTU_BAUD_RATE = "rtu_baud_rate"
+CONF_LATENCY_TARGETS = "latency_targets"
+CONF_STATS_INTERVAL = "stats_interval"
 
 # Namespace
 modbus_tcp_ns = cg.esphome_ns.namespace("modbus_tcp")
 ModbusTCPManager = modbus_tcp_ns.class_("ModbusTCPManager", cg.Component)
+ModbusTransportType = modbus_tcp_ns.enum("ModbusTransportType", is_class=True)
+
+# Framing used on the TCP socket
+TRANSPORT_TYPES = {
+    "tcp": ModbusTransportType.MBAP,
+    "rtu_over_tcp": ModbusTransportType.RTU_OVER_TCP,
+}
+
+# Request queue lanes, highest priority first
+RequestPriority = modbus_tcp_ns.enum("RequestPriority", is_class=True)
+PRIORITY_LANES = {
+    "safe_mode": RequestPriority.SAFE_MODE,
+    "control": RequestPriority.CONTROL,
+    "watchdog": RequestPriority.WATCHDOG,
+    "poll": RequestPriority.POLL,
+}
 
 # Dependencies
 DEPENDENCIES = ["network"]
@@ -24,15 +44,24 @@ SAFE_MODE_REGISTER_SCHEMA = cv.Schema({
     cv.Required("value"): cv.int_range(min=-32768, max=32767),
 })
 
+# Per-lane queue wait target; waits above it are logged and counted
+LATENCY_TARGETS_SCHEMA = cv.Schema({
+    cv.Optional(lane): cv.positive_time_period_milliseconds for lane in PRIORITY_LANES
+})
+
 # Configuration schema
 CONFIG_SCHEMA = cv.Schema({
     cv.GenerateID(): cv.declare_id(ModbusTCPManager),
     cv.Required(CONF_HOST): cv.string,
     cv.Optional(CONF_PORT, default=502): cv.port,
     cv.Optional(CONF_UNIT_ID, default=1): cv.int_range(min=1, max=255),
+    cv.Optional(CONF_TRANSPORT, default="tcp"): cv.enum(TRANSPORT_TYPES, lower=True),
+    cv.Optional(CONF_RTU_BAUD_RATE, default=9600): cv.int_range(min=300, max=921600),
     cv.Optional(CONF_WATCHDOG_REGISTER): cv.positive_int,
     cv.Optional(CONF_WATCHDOG_INTERVAL, default="10s"): cv.positive_time_period_milliseconds,
     cv.Optional(CONF_SAFE_MODE_REGISTERS, default=[]): cv.All(cv.ensure_list(SAFE_MODE_REGISTER_SCHEMA)),
+    cv.Optional(CONF_LATENCY_TARGETS, default={}): LATENCY_TARGETS_SCHEMA,
+    cv.Optional(CONF_STATS_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
 }).extend(cv.COMPONENT_SCHEMA)
 
 async def to_code(config):
@@ -43,6 +72,10 @@ async def to_code(config):
         config[CONF_UNIT_ID]
     )
     
+    # Framing: plain Modbus TCP or RTU frames tunnelled over TCP
+    cg.add(var.set_transport_type(config[CONF_TRANSPORT]))
+    cg.add(var.set_rtu_baud_rate(config[CONF_RTU_BAUD_RATE]))
+    
     # Add watchdog configuration if specified
     if CONF_WATCHDOG_REGISTER in config:
         cg.add(var.set_watchdog_register(config[CONF_WATCHDOG_REGISTER]))
@@ -52,4 +85,9 @@ async def to_code(config):
     for safe_reg in config[CONF_SAFE_MODE_REGISTERS]:
         cg.add(var.add_safe_mode_register(safe_reg["register"], safe_reg["value"]))
     
+    # Override default queue latency targets
+    for lane, target in config[CONF_LATENCY_TARGETS].items():
+        cg.add(var.set_latency_target(PRIORITY_LANES[lane], target))
+    cg.add(var.set_stats_interval(config[CONF_STATS_INTERVAL]))
+    
     await cg.register_component(var, config)
@@ -5,9 +5,13 @@
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #include "esphome/core/log.h"
 #include "esphome/core/helpers.h"
+#include "modbus_transport.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <deque>
+#include <functional>
+#include <cinttypes>
 
 #ifdef USE_ESP32
 #include "lwip/sockets.h"
@@ -18,10 +22,24 @@
 #include <sys/select.h>
 #endif
 
+// Host platform build, used to run against tools/modbus_sim on Linux
+#ifdef USE_HOST
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/select.h>
+#endif
+
 namespace esphome {
 namespace modbus_tcp {
 
 static const char *const TAG = "modbus_tcp_manager";
+static const uint32_t RECEIVE_TIMEOUT_MS = 2000;
+static const size_t MAX_LANE_DEPTH = 16;
 
 enum class ModbusFunction : uint8_t {
     READ_COILS = 0x01,
@@ -38,6 +56,30 @@ struct ModbusResponse {
     bool success;
     std::vector<uint16_t> data;
     std::string error_message;
+    bool dropped = false;  // Rejected locally by a full queue, never sent
+};
+
+using ModbusCallback = std::function<void(const ModbusResponse &)>;
+
+// Queue lanes, highest priority first. A queued request is only served once
+// every higher lane is empty, so control writes never wait behind polling.
+enum class RequestPriority : uint8_t {
+    SAFE_MODE = 0,
+    CONTROL = 1,
+    WATCHDOG = 2,
+    POLL = 3
+};
+static const uint8_t PRIORITY_LANE_COUNT = 4;
+
+// Queue wait measurements for one lane (enqueue until the transaction starts)
+struct LaneStats {
+    uint32_t target_ms;
+    uint32_t completed;  // Counted once the transaction has run
+    uint32_t target_misses;
+    uint32_t dropped;
+    uint32_t last_wait_ms;
+    uint32_t max_wait_ms;
+    uint64_t total_wait_ms;
 };
 
 class ModbusTCPManager : public Component {
@@ -45,15 +87,30 @@ public:
     ModbusTCPManager(const std::string &host, uint16_t port, uint8_t unit_id) 
         : host_(host), port_(port), unit_id_(unit_id), 
           is_connected_(false), last_connection_attempt_(0),
+          transport_type_(ModbusTransportType::MBAP), rtu_baud_rate_(9600),
+          transport_(new MbapTransport()),
           watchdog_register_(0), watchdog_enabled_(false), 
           watchdog_interval_(10000), last_watchdog_time_(0),
           watchdog_counter_(0), safe_mode_active_(false),
           connection_check_state_(ConnectionCheckState::IDLE),
           connection_check_sock_(-1), connection_check_start_time_(0),
-          connection_check_success_(false) {}
+          connection_check_success_(false),
+          watchdog_pending_(false), stats_interval_(60000), last_stats_log_(0),
+          disconnected_since_(0), transactions_(0), failed_transactions_(0),
+          max_loop_us_(0), max_recovery_ms_(0) {
+        static const uint32_t DEFAULT_TARGETS_MS[PRIORITY_LANE_COUNT] = {100, 200, 1000, 5000};
+        for (uint8_t i = 0; i < PRIORITY_LANE_COUNT; i++) {
+            lane_stats_[i] = LaneStats{DEFAULT_TARGETS_MS[i], 0, 0, 0, 0, 0, 0};
+        }
+    }
 
     void setup() override {
-        ESP_LOGD(TAG, "Setting up Modbus TCP Manager for %s:%d", host_.c_str(), port_);
+        if (transport_type_ == ModbusTransportType::RTU_OVER_TCP) {
+            transport_.reset(new RtuOverTcpTransport(rtu_baud_rate_));
+        } else {
+            transport_.reset(new MbapTransport());
+        }
+        ESP_LOGD(TAG, "Setting up Modbus TCP Manager for %s:%d (%s)", host_.c_str(), port_, transport_->get_name());
     }
 
     // Configuration methods
@@ -67,14 +124,44 @@ public:
         watchdog_interval_ = interval; 
     }
     
+    void set_transport_type(ModbusTransportType type) {
+        transport_type_ = type;
+    }
+    
+    void set_rtu_baud_rate(uint32_t baud_rate) {
+        rtu_baud_rate_ = baud_rate;
+    }
+    
     void add_safe_mode_register(uint16_t reg, int16_t value) {
         safe_mode_registers_.push_back({reg, value});
         ESP_LOGD(TAG, "Added safe mode: register %d = %d", reg, value);
     }
+    
+    void set_latency_target(RequestPriority priority, uint32_t target_ms) {
+        lane_stats_[static_cast<uint8_t>(priority)].target_ms = target_ms;
+    }
+    
+    void set_stats_interval(uint32_t interval) {
+        stats_interval_ = interval;
+    }
+
+    void dump_config() override {
+        ESP_LOGCONFIG(TAG, "Modbus TCP Manager:");
+        ESP_LOGCONFIG(TAG, "  Host: %s:%d (unit %d)", host_.c_str(), port_, unit_id_);
+        ESP_LOGCONFIG(TAG, "  Transport: %s", transport_->get_name());
+        for (uint8_t i = 0; i < PRIORITY_LANE_COUNT; i++) {
+            ESP_LOGCONFIG(TAG, "  Lane %s latency target: %" PRIu32 " ms",
+                          priority_to_string(static_cast<RequestPriority>(i)), lane_stats_[i].target_ms);
+        }
+    }
 
     void loop() override {
+        uint32_t loop_start = micros();
         uint32_t now = millis();
         
+        // Serve at most one queued transaction per loop, highest lane first
+        process_queue();
+        
         // Non-blocking connection health check - keep 5 second interval
         if (now - last_connection_attempt_ > 5000) {
             last_connection_attempt_ = now;
@@ -89,6 +176,17 @@ public:
             handle_watchdog();
         }
         
+        if (now - last_stats_log_ > stats_interval_) {
+            last_stats_log_ = now;
+            log_stats();
+        }
+        
+        // Track the longest time this component held the main loop
+        uint32_t loop_us = micros() - loop_start;
+        if (loop_us > max_loop_us_) {
+            max_loop_us_ = loop_us;
+        }
+        
         // Yield regularly for responsiveness
         if (now % 10 == 0) {
             yield();
@@ -102,7 +200,7 @@ public:
     
     // Force connection status update (used by sensors)
     void mark_connection_failed() { 
-        is_connected_ = false; 
+        set_connected(false); 
     }
 
     // Public connection check method (now also non-blocking)
@@ -114,6 +212,41 @@ public:
         start_connection_check();
     }
 
+    // Queued reads - the callback runs from loop() once the transaction completes
+    bool queue_read(uint16_t start_address, uint16_t count, ModbusFunction function,
+                    RequestPriority priority, ModbusCallback callback) {
+        QueuedRequest request;
+        request.function = function;
+        request.address = start_address;
+        request.count = count;
+        request.callback = std::move(callback);
+        return enqueue(priority, std::move(request));
+    }
+
+    // Queued single register write, CONTROL lane by default
+    bool queue_write_register(uint16_t address, int16_t value,
+                              RequestPriority priority = RequestPriority::CONTROL,
+                              ModbusCallback callback = nullptr) {
+        return queue_write(ModbusFunction::WRITE_SINGLE_REGISTER, address, std::vector<int16_t>{value},
+                           priority, std::move(callback));
+    }
+
+    // Queued multiple register write, CONTROL lane by default
+    bool queue_write_registers(uint16_t start_address, const std::vector<int16_t>& values,
+                               RequestPriority priority = RequestPriority::CONTROL,
+                               ModbusCallback callback = nullptr) {
+        return queue_write(ModbusFunction::WRITE_MULTIPLE_REGISTERS, start_address, values,
+                           priority, std::move(callback));
+    }
+
+    const LaneStats &get_lane_stats(RequestPriority priority) const {
+        return lane_stats_[static_cast<uint8_t>(priority)];
+    }
+
+    size_t get_queue_depth(RequestPriority priority) const {
+        return lanes_[static_cast<uint8_t>(priority)].size();
+    }
+
     // Read single register
     ModbusResponse read_register(uint16_t address, ModbusFunction function = ModbusFunction::READ_HOLDING_REGISTERS) {
         return read_registers(address, 1, function);
@@ -124,66 +257,48 @@ public:
         ModbusResponse response;
         response.success = false;
 
-        int sock = create_connection();
-        if (sock < 0) {
-            response.error_message = "Connection failed";
-            is_connected_ = false;
+        std::vector<uint8_t> pdu;
+        if (!transact(build_read_request(start_address, count, function), pdu, response.error_message)) {
+            set_connected(false);
             return response;
         }
 
-        std::vector<uint8_t> request = build_read_request(start_address, count, function);
-        
-        if (!send_data(sock, request)) {
-            ::close(sock);
-            response.error_message = "Send failed";
-            is_connected_ = false;
+        // The device answered but rejected the request - the link itself is fine
+        if (!check_exception(pdu, function, response.error_message)) {
+            set_connected(true);
             return response;
         }
 
-        std::vector<uint8_t> resp_data = receive_data(sock);
-        ::close(sock);
-
-        if (resp_data.empty()) {
-            response.error_message = "Receive failed";
-            is_connected_ = false;
+        if (!parse_read_response(pdu, response, function)) {
+            set_connected(false);
             return response;
         }
 
-        if (!parse_read_response(resp_data, response, function)) {
-            is_connected_ = false;
-            return response;
-        }
-
-        is_connected_ = true;
+        set_connected(true);
         response.success = true;
         return response;
     }
 
     // Write single register
     bool write_register(uint16_t address, int16_t value) {
-        ESP_LOGD(TAG, "Writing value %d to register %d", value, address);
-        
-        int sock = create_connection();
-        if (sock < 0) {
-            is_connected_ = false;
-            return false;
-        }
+        std::string error;
+        return write_register(address, value, error);
+    }
 
-        std::vector<uint8_t> request = build_write_request(address, value);
-        
-        bool success = send_data(sock, request);
-        if (success) {
-            std::vector<uint8_t> response = receive_data(sock);
-            success = !response.empty() && response.size() >= 8;
-        }
+    // Write single register, reporting the failure cause
+    bool write_register(uint16_t address, int16_t value, std::string& error) {
+        ESP_LOGD(TAG, "Writing value %d to register %d", value, address);
         
-        ::close(sock);
-        is_connected_ = success;
+        std::vector<uint8_t> pdu;
+        bool answered = transact(build_write_request(address, value), pdu, error);
+        bool success = answered && check_write_response(pdu, ModbusFunction::WRITE_SINGLE_REGISTER, error);
+        // An exception reply still means the device answered
+        set_connected(success || (answered && is_exception(pdu, ModbusFunction::WRITE_SINGLE_REGISTER)));
         
         if (success) {
             ESP_LOGD(TAG, "Successfully wrote value %d to register %d", value, address);
         } else {
-            ESP_LOGW(TAG, "Failed to write to register %d", address);
+            ESP_LOGW(TAG, "Failed to write to register %d: %s", address, error.c_str());
         }
         
         return success;
@@ -191,34 +306,30 @@ public:
 
     // Write multiple registers
     bool write_registers(uint16_t start_address, const std::vector<int16_t>& values) {
-        ESP_LOGD(TAG, "Writing %d values starting at register %d", values.size(), start_address);
+        std::string error;
+        return write_registers(start_address, values, error);
+    }
+
+    // Write multiple registers, reporting the failure cause
+    bool write_registers(uint16_t start_address, const std::vector<int16_t>& values, std::string& error) {
+        ESP_LOGD(TAG, "Writing %zu values starting at register %d", values.size(), start_address);
         
         if (values.empty() || values.size() > 123) {
-            ESP_LOGE(TAG, "Invalid value count: %d", values.size());
-            return false;
-        }
-
-        int sock = create_connection();
-        if (sock < 0) {
-            is_connected_ = false;
+            ESP_LOGE(TAG, "Invalid value count: %zu", values.size());
+            error = "Invalid value count";
             return false;
         }
 
-        std::vector<uint8_t> request = build_write_multiple_request(start_address, values);
+        std::vector<uint8_t> pdu;
+        bool answered = transact(build_write_multiple_request(start_address, values), pdu, error);
+        bool success = answered && check_write_response(pdu, ModbusFunction::WRITE_MULTIPLE_REGISTERS, error);
+        // An exception reply still means the device answered
+        set_connected(success || (answered && is_exception(pdu, ModbusFunction::WRITE_MULTIPLE_REGISTERS)));
         
-        bool success = send_data(sock, request);
         if (success) {
-            std::vector<uint8_t> response = receive_data(sock);
-            success = !response.empty() && response.size() >= 8;
-        }
-        
-        ::close(sock);
-        is_connected_ = success;
-        
-        if (success) {
-            ESP_LOGD(TAG, "Successfully wrote %d values starting at register %d", values.size(), start_address);
+            ESP_LOGD(TAG, "Successfully wrote %zu values starting at register %d", values.size(), start_address);
         } else {
-            ESP_LOGW(TAG, "Failed to write multiple registers starting at %d", start_address);
+            ESP_LOGW(TAG, "Failed to write multiple registers starting at %d: %s", start_address, error.c_str());
         }
         
         return success;
@@ -230,7 +341,11 @@ private:
     uint8_t unit_id_;
     bool is_connected_;
     uint32_t last_connection_attempt_;
-    uint16_t transaction_id_ = 1;
+    
+    // Framing (MBAP or RTU over TCP), shared by all request types
+    ModbusTransportType transport_type_;
+    uint32_t rtu_baud_rate_;
+    std::unique_ptr<ModbusTransport> transport_;
     
     // Watchdog variables
     uint16_t watchdog_register_;
@@ -251,6 +366,28 @@ private:
     uint32_t connection_check_start_time_;
     bool connection_check_success_;  // Track whether the check succeeded
     
+    // Priority lanes
+    struct QueuedRequest {
+        ModbusFunction function;
+        uint16_t address;
+        uint16_t count;
+        std::vector<int16_t> values;
+        ModbusCallback callback;
+        uint32_t enqueued_at;
+    };
+    std::deque<QueuedRequest> lanes_[PRIORITY_LANE_COUNT];
+    LaneStats lane_stats_[PRIORITY_LANE_COUNT];
+    bool watchdog_pending_;
+    
+    // Performance counters, reported every stats_interval_
+    uint32_t stats_interval_;
+    uint32_t last_stats_log_;
+    uint32_t disconnected_since_;
+    uint32_t transactions_;
+    uint32_t failed_transactions_;
+    uint32_t max_loop_us_;
+    uint32_t max_recovery_ms_;
+    
     // Safe mode configuration
     struct SafeModeRegister {
         uint16_t register_addr;
@@ -258,6 +395,143 @@ private:
     };
     std::vector<SafeModeRegister> safe_mode_registers_;
 
+    static const char *priority_to_string(RequestPriority priority) {
+        switch (priority) {
+            case RequestPriority::SAFE_MODE: return "safe_mode";
+            case RequestPriority::CONTROL: return "control";
+            case RequestPriority::WATCHDOG: return "watchdog";
+            case RequestPriority::POLL: return "poll";
+        }
+        return "unknown";
+    }
+
+    bool queue_write(ModbusFunction function, uint16_t start_address, const std::vector<int16_t>& values,
+                     RequestPriority priority, ModbusCallback callback) {
+        QueuedRequest request;
+        request.function = function;
+        request.address = start_address;
+        request.count = values.size();
+        request.values = values;
+        request.callback = std::move(callback);
+        return enqueue(priority, std::move(request));
+    }
+
+    bool enqueue(RequestPriority priority, QueuedRequest request) {
+        uint8_t lane = static_cast<uint8_t>(priority);
+        
+        // Safe mode writes are never dropped, however many registers are configured
+        if (priority != RequestPriority::SAFE_MODE && lanes_[lane].size() >= MAX_LANE_DEPTH) {
+            ESP_LOGW(TAG, "Lane %s full, dropping request for register %d", priority_to_string(priority), request.address);
+            lane_stats_[lane].dropped++;
+            if (request.callback) {
+                ModbusResponse response;
+                response.success = false;
+                response.error_message = "Queue full";
+                response.dropped = true;
+                request.callback(response);
+            }
+            return false;
+        }
+        
+        request.enqueued_at = millis();
+        lanes_[lane].push_back(std::move(request));
+        return true;
+    }
+
+    // Pop the oldest request from the highest non-empty lane and run it
+    void process_queue() {
+        for (uint8_t lane = 0; lane < PRIORITY_LANE_COUNT; lane++) {
+            if (lanes_[lane].empty()) {
+                continue;
+            }
+            
+            QueuedRequest request = std::move(lanes_[lane].front());
+            lanes_[lane].pop_front();
+            
+            record_queue_wait(static_cast<RequestPriority>(lane), millis() - request.enqueued_at);
+            
+            ModbusResponse response = execute(request);
+            lane_stats_[lane].completed++;
+            if (request.callback) {
+                request.callback(response);
+            }
+            return;
+        }
+    }
+
+    ModbusResponse execute(const QueuedRequest &request) {
+        if (request.function == ModbusFunction::WRITE_SINGLE_REGISTER ||
+            request.function == ModbusFunction::WRITE_MULTIPLE_REGISTERS) {
+            ModbusResponse response;
+            response.success = request.function == ModbusFunction::WRITE_SINGLE_REGISTER
+                                   ? write_register(request.address, request.values[0], response.error_message)
+                                   : write_registers(request.address, request.values, response.error_message);
+            return response;
+        }
+        
+        return read_registers(request.address, request.count, request.function);
+    }
+
+    void record_queue_wait(RequestPriority priority, uint32_t wait_ms) {
+        LaneStats &stats = lane_stats_[static_cast<uint8_t>(priority)];
+        stats.last_wait_ms = wait_ms;
+        stats.total_wait_ms += wait_ms;
+        if (wait_ms > stats.max_wait_ms) {
+            stats.max_wait_ms = wait_ms;
+        }
+        
+        if (wait_ms > stats.target_ms) {
+            stats.target_misses++;
+            ESP_LOGW(TAG, "Lane %s waited %" PRIu32 " ms in queue (target %" PRIu32 " ms)",
+                     priority_to_string(priority), wait_ms, stats.target_ms);
+        }
+    }
+
+    // Single place where the connection state changes, so outages can be timed
+    void set_connected(bool connected) {
+        if (connected == is_connected_) {
+            return;
+        }
+        
+        uint32_t now = millis();
+        if (connected) {
+            if (disconnected_since_ != 0) {
+                uint32_t outage_ms = now - disconnected_since_;
+                if (outage_ms > max_recovery_ms_) {
+                    max_recovery_ms_ = outage_ms;
+                }
+                ESP_LOGI(TAG, "Modbus connection restored to %s:%d after %" PRIu32 " ms", host_.c_str(), port_, outage_ms);
+            } else {
+                ESP_LOGI(TAG, "Modbus connection established to %s:%d", host_.c_str(), port_);
+            }
+        } else {
+            ESP_LOGW(TAG, "Modbus connection lost to %s:%d", host_.c_str(), port_);
+            disconnected_since_ = now != 0 ? now : 1;
+        }
+        is_connected_ = connected;
+    }
+
+    void log_stats() {
+        // Fixed format, parsed by tools/modbus_sim
+        ESP_LOGD(TAG, "Perf: %" PRIu32 " transactions, %" PRIu32 " failed, loop stall max %" PRIu32 " ms, recovery max %" PRIu32 " ms",
+                 transactions_, failed_transactions_, max_loop_us_ / 1000, max_recovery_ms_);
+        max_loop_us_ = 0;
+        log_lane_stats();
+    }
+
+    void log_lane_stats() {
+        for (uint8_t i = 0; i < PRIORITY_LANE_COUNT; i++) {
+            const LaneStats &stats = lane_stats_[i];
+            if (stats.completed == 0 && stats.dropped == 0) {
+                continue;
+            }
+            ESP_LOGD(TAG, "Lane %s: %" PRIu32 " done, avg wait %" PRIu32 " ms, max %" PRIu32 " ms, %" PRIu32 " over target, %" PRIu32 " dropped, %zu queued",
+                     priority_to_string(static_cast<RequestPriority>(i)), stats.completed,
+                     stats.completed > 0 ? (uint32_t) (stats.total_wait_ms / stats.completed) : 0,
+                     stats.max_wait_ms, stats.target_misses, stats.dropped, lanes_[i].size());
+        }
+    }
+
     // Start non-blocking connection check
     void start_connection_check() {
         if (connection_check_state_ != ConnectionCheckState::IDLE) {
@@ -360,17 +634,7 @@ private:
                 }
                 
                 // Update connection status based on the check result
-                if (connection_check_success_) {
-                    if (!is_connected_) {
-                        ESP_LOGI(TAG, "Modbus connection restored to %s:%d", host_.c_str(), port_);
-                        is_connected_ = true;
-                    }
-                } else {
-                    if (is_connected_) {
-                        ESP_LOGW(TAG, "Modbus connection lost to %s:%d", host_.c_str(), port_);
-                        is_connected_ = false;
-                    }
-                }
+                set_connected(connection_check_success_);
                 
                 connection_check_state_ = ConnectionCheckState::IDLE;
                 break;
@@ -387,35 +651,52 @@ private:
             return;
         }
         
+        // Previous round still queued - don't stack another behind it
+        if (watchdog_pending_) {
+            return;
+        }
+        watchdog_pending_ = true;
+        
         // Write watchdog counter
         watchdog_counter_++;
-        bool write_success = write_register(watchdog_register_, watchdog_counter_);
-        
-        if (write_success) {
-            delay(100);
-            ModbusResponse response = read_register(watchdog_register_);
+        queue_write_register(watchdog_register_, watchdog_counter_, RequestPriority::WATCHDOG,
+                             [this](const ModbusResponse &write_response) {
+            if (!write_response.success) {
+                ESP_LOGW(TAG, "Watchdog write failed");
+                watchdog_pending_ = false;
+                activate_safe_mode();
+                return;
+            }
             
-            if (response.success && !response.data.empty()) {
-                uint16_t read_value = response.data[0];
+            // Give the remote device time to increment before reading back
+            this->set_timeout("watchdog_read", 100, [this]() {
+                queue_read(watchdog_register_, 1, ModbusFunction::READ_HOLDING_REGISTERS, RequestPriority::WATCHDOG,
+                           [this](const ModbusResponse &response) {
+                    watchdog_pending_ = false;
+                    check_watchdog_response(response);
+                });
+            });
+        });
+    }
+    
+    void check_watchdog_response(const ModbusResponse &response) {
+        if (response.success && !response.data.empty()) {
+            uint16_t read_value = response.data[0];
+            
+            if (read_value != watchdog_counter_) {
+                ESP_LOGD(TAG, "Watchdog OK: wrote %d, read %d", watchdog_counter_, read_value);
+                watchdog_counter_ = read_value;
                 
-                if (read_value != watchdog_counter_) {
-                    ESP_LOGD(TAG, "Watchdog OK: wrote %d, read %d", watchdog_counter_, read_value);
-                    watchdog_counter_ = read_value;
-                    
-                    if (safe_mode_active_) {
-                        ESP_LOGI(TAG, "Watchdog restored, deactivating safe mode");
-                        safe_mode_active_ = false;
-                    }
-                } else {
-                    ESP_LOGW(TAG, "Watchdog failed: remote device not responding");
-                    activate_safe_mode();
+                if (safe_mode_active_) {
+                    ESP_LOGI(TAG, "Watchdog restored, deactivating safe mode");
+                    safe_mode_active_ = false;
                 }
             } else {
-                ESP_LOGW(TAG, "Watchdog read failed");
+                ESP_LOGW(TAG, "Watchdog failed: remote device not responding");
                 activate_safe_mode();
             }
         } else {
-            ESP_LOGW(TAG, "Watchdog write failed");
+            ESP_LOGW(TAG, "Watchdog read failed");
             activate_safe_mode();
         }
     }
@@ -423,12 +704,19 @@ private:
     void activate_safe_mode() {
         if (safe_mode_active_) return;
         
-        ESP_LOGW(TAG, "Activating safe mode - writing %d safe values", safe_mode_registers_.size());
+        ESP_LOGW(TAG, "Activating safe mode - queueing %zu safe values", safe_mode_registers_.size());
         safe_mode_active_ = true;
         
         for (const auto& safe_reg : safe_mode_registers_) {
-            write_register(safe_reg.register_addr, safe_reg.value);
-            ESP_LOGI(TAG, "Safe mode: Set register %d = %d", safe_reg.register_addr, safe_reg.value);
+            uint16_t reg = safe_reg.register_addr;
+            int16_t value = safe_reg.value;
+            queue_write_register(reg, value, RequestPriority::SAFE_MODE, [reg, value](const ModbusResponse &response) {
+                if (response.success) {
+                    ESP_LOGI(TAG, "Safe mode: Set register %d = %d", reg, value);
+                } else {
+                    ESP_LOGW(TAG, "Safe mode: Failed to set register %d", reg);
+                }
+            });
         }
     }
 
@@ -510,31 +798,100 @@ private:
     bool send_data(int sock, const std::vector<uint8_t>& data) {
         int sent = ::send(sock, data.data(), data.size(), 0);
         if (sent != (int)data.size()) {
-            ESP_LOGV(TAG, "Send failed: %d/%d bytes", sent, data.size());
+            ESP_LOGV(TAG, "Send failed: %d/%zu bytes", sent, data.size());
             return false;
         }
         return true;
     }
 
+    // Read until the transport reports a complete frame, the frame gap expires or we time out
     std::vector<uint8_t> receive_data(int sock) {
         std::vector<uint8_t> data;
         uint8_t buffer[256];
+        uint32_t start = millis();
+        uint32_t frame_gap = transport_->get_frame_gap_ms();
         
-        int len = ::recv(sock, buffer, sizeof(buffer), 0);
-        if (len > 0) {
-            data.assign(buffer, buffer + len);
+        while (true) {
+            size_t expected = transport_->expected_frame_length(data);
+            if (expected > 0 && expected != FRAME_LENGTH_UNKNOWN && data.size() >= expected) {
+                data.resize(expected);
+                break;
+            }
+            
+            uint32_t elapsed = millis() - start;
+            if (elapsed >= RECEIVE_TIMEOUT_MS) {
+                ESP_LOGV(TAG, "Receive timeout with %zu bytes buffered", data.size());
+                break;
+            }
+            
+            uint32_t wait_ms = RECEIVE_TIMEOUT_MS - elapsed;
+            // Only an unknown function code ends on the frame gap; a short known frame keeps waiting
+            if (frame_gap > 0 && expected == FRAME_LENGTH_UNKNOWN && frame_gap < wait_ms) {
+                wait_ms = frame_gap;
+            }
+            
+            fd_set read_fds;
+            FD_ZERO(&read_fds);
+            FD_SET(sock, &read_fds);
+            
+            struct timeval timeout;
+            timeout.tv_sec = wait_ms / 1000;
+            timeout.tv_usec = (wait_ms % 1000) * 1000;
+            
+            if (::select(sock + 1, &read_fds, nullptr, nullptr, &timeout) <= 0) {
+                break;  // Timeout, frame gap elapsed or socket error
+            }
+            
+            int len = ::recv(sock, buffer, sizeof(buffer), 0);
+            if (len <= 0) {
+                break;  // Peer closed or reset the connection
+            }
+            data.insert(data.end(), buffer, buffer + len);
         }
         
         return data;
     }
 
+    // Counted wrapper around exchange() for the perf stats
+    bool transact(const std::vector<uint8_t>& request_pdu, std::vector<uint8_t>& response_pdu, std::string& error) {
+        transactions_++;
+        if (!exchange(request_pdu, response_pdu, error)) {
+            failed_transactions_++;
+            return false;
+        }
+        return true;
+    }
+
+    // One request/response exchange on a fresh connection, framed by the active transport
+    bool exchange(const std::vector<uint8_t>& request_pdu, std::vector<uint8_t>& response_pdu, std::string& error) {
+        int sock = create_connection();
+        if (sock < 0) {
+            error = "Connection failed";
+            return false;
+        }
+
+        transport_->before_send();
+        
+        if (!send_data(sock, transport_->encode_request(unit_id_, request_pdu))) {
+            ::close(sock);
+            error = "Send failed";
+            return false;
+        }
+
+        std::vector<uint8_t> frame = receive_data(sock);
+        transport_->after_receive();
+        ::close(sock);
+
+        if (frame.empty()) {
+            error = "Receive failed";
+            return false;
+        }
+
+        return transport_->decode_response(unit_id_, frame, response_pdu, error);
+    }
+
     std::vector<uint8_t> build_read_request(uint16_t address, uint16_t count, ModbusFunction function) {
         return {
-            static_cast<uint8_t>((transaction_id_ >> 8) & 0xFF),
-            static_cast<uint8_t>(transaction_id_++ & 0xFF),
-            0x00, 0x00,
-            0x00, 0x06,
-            unit_id_,
             static_cast<uint8_t>(function),
             static_cast<uint8_t>((address >> 8) & 0xFF),
             static_cast<uint8_t>(address & 0xFF),
@@ -545,11 +902,6 @@ private:
 
     std::vector<uint8_t> build_write_request(uint16_t address, int16_t value) {
         return {
-            static_cast<uint8_t>((transaction_id_ >> 8) & 0xFF),
-            static_cast<uint8_t>(transaction_id_++ & 0xFF),
-            0x00, 0x00,
-            0x00, 0x06,
-            unit_id_,
             0x06,
             static_cast<uint8_t>((address >> 8) & 0xFF),
             static_cast<uint8_t>(address & 0xFF),
@@ -563,12 +915,6 @@ private:
         uint8_t byte_count = count * 2;
         
         std::vector<uint8_t> request = {
-            static_cast<uint8_t>((transaction_id_ >> 8) & 0xFF),
-            static_cast<uint8_t>(transaction_id_++ & 0xFF),
-            0x00, 0x00,
-            static_cast<uint8_t>(((7 + byte_count) >> 8) & 0xFF),
-            static_cast<uint8_t>((7 + byte_count) & 0xFF),
-            unit_id_,
             0x10,
             static_cast<uint8_t>((address >> 8) & 0xFF),
             static_cast<uint8_t>(address & 0xFF),
@@ -585,26 +931,52 @@ private:
         return request;
     }
 
-    bool parse_read_response(const std::vector<uint8_t>& data, ModbusResponse& response, ModbusFunction function) {
-        if (data.size() < 9) {
+    // Exception responses echo the function code with the high bit set
+    bool is_exception(const std::vector<uint8_t>& pdu, ModbusFunction function) {
+        return pdu.size() >= 2 && pdu[0] == (static_cast<uint8_t>(function) | 0x80);
+    }
+
+    bool check_exception(const std::vector<uint8_t>& pdu, ModbusFunction function, std::string& error) {
+        if (is_exception(pdu, function)) {
+            error = str_sprintf("Modbus exception %d", pdu[1]);
+            return false;
+        }
+        return true;
+    }
+
+    bool check_write_response(const std::vector<uint8_t>& pdu, ModbusFunction function, std::string& error) {
+        if (!check_exception(pdu, function, error)) {
+            return false;
+        }
+        
+        if (pdu.size() < 5 || pdu[0] != static_cast<uint8_t>(function)) {
+            error = "Invalid write response";
+            return false;
+        }
+        
+        return true;
+    }
+
+    bool parse_read_response(const std::vector<uint8_t>& pdu, ModbusResponse& response, ModbusFunction function) {
+        if (pdu.size() < 2) {
             response.error_message = "Response too short";
             return false;
         }
 
-        if (data[7] != static_cast<uint8_t>(function)) {
+        if (pdu[0] != static_cast<uint8_t>(function)) {
             response.error_message = "Invalid function code";
             return false;
         }
 
-        uint8_t byte_count = data[8];
-        if (data.size() < 9 + byte_count) {
+        uint8_t byte_count = pdu[1];
+        if (pdu.size() < 2u + byte_count) {
             response.error_message = "Incomplete response";
             return false;
         }
 
         response.data.clear();
-        for (int i = 0; i < byte_count; i += 2) {
-            uint16_t value = (data[9 + i] << 8) | data[9 + i + 1];
+        for (int i = 0; i + 1 < byte_count; i += 2) {
+            uint16_t value = (pdu[2 + i] << 8) | pdu[2 + i + 1];
             response.data.push_back(value);
         }
 
@@ -637,43 +1009,47 @@ public:
             }
         }
 
-        // Simple rate limiting to prevent all sensors updating simultaneously
-        static uint32_t last_any_update = 0;
-        uint32_t now = millis();
-        
-        if (now - last_any_update < 200) {
-            ESP_LOGV(TAG, "Rate limiting sensor %d, skipping update", register_address_);
+        // Previous poll still waiting in the queue
+        if (pending_) {
+            ESP_LOGV(TAG, "Poll for register %d still queued, skipping update", register_address_);
             return;
         }
-        last_any_update = now;
 
         ModbusFunction func = (function_code_ == 4) ? 
             ModbusFunction::READ_INPUT_REGISTERS : 
             ModbusFunction::READ_HOLDING_REGISTERS;
 
         ESP_LOGD(TAG, "Reading register %d", register_address_);
-        ModbusResponse response = parent_->read_register(register_address_, func);
-        
+        pending_ = parent_->queue_read(register_address_, 1, func, RequestPriority::POLL,
+                                       [this](const ModbusResponse &response) {
+            pending_ = false;
+            handle_response(response);
+        });
+    }
+
+private:
+    ModbusTCPManager *parent_;
+    uint16_t register_address_;
+    uint8_t function_code_;
+    float scale_;
+    float offset_;
+    bool pending_ = false;
+
+    void handle_response(const ModbusResponse &response) {
         if (response.success && !response.data.empty()) {
             int16_t raw_value = static_cast<int16_t>(response.data[0]);
             float scaled_value = (raw_value * scale_) + offset_;
             
             ESP_LOGD(TAG, "Register %d: raw=%d, scaled=%.2f", register_address_, raw_value, scaled_value);
             this->publish_state(scaled_value);
+        } else if (response.dropped) {
+            // Local backlog, says nothing about the link
+            ESP_LOGW(TAG, "Poll for register %d dropped: %s", register_address_, response.error_message.c_str());
         } else {
+            // The manager already marked the link down if the transport failed
             ESP_LOGW(TAG, "Failed to read register %d: %s", register_address_, response.error_message.c_str());
-            const_cast<ModbusTCPManager*>(parent_)->mark_connection_failed();
         }
-        
-        yield();
     }
-
-private:
-    ModbusTCPManager *parent_;
-    uint16_t register_address_;
-    uint8_t function_code_;
-    float scale_;
-    float offset_;
 };
 
 // Connection status sensor
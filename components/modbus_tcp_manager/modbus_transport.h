@@ -0,0 +1,273 @@
+#pragma once
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace modbus_tcp {
+
+enum class ModbusTransportType : uint8_t {
+    MBAP,          // Modbus TCP (7-byte MBAP header, no checksum)
+    RTU_OVER_TCP   // Raw RTU frames (unit id + PDU + CRC-16) tunnelled over a TCP socket
+};
+
+// Modbus CRC-16 lookup table (polynomial 0xA001, reflected)
+static const uint16_t MODBUS_CRC16_TABLE[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+
+// Table-driven Modbus CRC-16 - one lookup per byte instead of eight shift/xor rounds
+inline uint16_t modbus_crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = (crc >> 8) ^ MODBUS_CRC16_TABLE[(crc ^ data[i]) & 0xFF];
+    }
+    return crc;
+}
+
+// Frame length result for function codes whose response size cannot be derived
+static const size_t FRAME_LENGTH_UNKNOWN = SIZE_MAX;
+
+// Length of a response PDU (function code + payload) from its first bytes.
+// Returns 0 while more bytes are needed, FRAME_LENGTH_UNKNOWN for unknown function codes.
+inline size_t modbus_response_pdu_length(const uint8_t *pdu, size_t available) {
+    if (available < 1) return 0;
+    
+    uint8_t function = pdu[0];
+    if (function & 0x80) {
+        return 2;  // Exception: function | 0x80, exception code
+    }
+    
+    switch (function) {
+        case 0x01:
+        case 0x02:
+        case 0x03:
+        case 0x04:
+            if (available < 2) return 0;
+            return 2 + pdu[1];  // Function, byte count, data
+        case 0x05:
+        case 0x06:
+        case 0x0F:
+        case 0x10:
+            return 5;  // Function, address, value/quantity echo
+        default:
+            return FRAME_LENGTH_UNKNOWN;
+    }
+}
+
+// Framing layer between the manager's PDUs and the bytes on the socket
+class ModbusTransport {
+public:
+    virtual ~ModbusTransport() = default;
+
+    virtual const char *get_name() const = 0;
+
+    // Wrap a request PDU (function code + payload) into a complete frame
+    virtual std::vector<uint8_t> encode_request(uint8_t unit_id, const std::vector<uint8_t>& pdu) = 0;
+
+    // Total frame length once enough of the response is buffered, 0 if more bytes are
+    // needed, FRAME_LENGTH_UNKNOWN if only the frame gap can delimit the response
+    virtual size_t expected_frame_length(const std::vector<uint8_t>& frame) const = 0;
+
+    // Validate the framing of a response and extract its PDU
+    virtual bool decode_response(uint8_t unit_id, const std::vector<uint8_t>& frame,
+                                 std::vector<uint8_t>& pdu, std::string& error) = 0;
+
+    // Idle time after which a frame of unknown function code is treated as complete (0 = disabled)
+    virtual uint32_t get_frame_gap_ms() const { return 0; }
+
+    // Hooks around each transaction, used for inter-frame timing
+    virtual void before_send() {}
+    virtual void after_receive() {}
+};
+
+// Standard Modbus TCP framing
+class MbapTransport : public ModbusTransport {
+public:
+    const char *get_name() const override { return "Modbus TCP"; }
+
+    std::vector<uint8_t> encode_request(uint8_t unit_id, const std::vector<uint8_t>& pdu) override {
+        last_transaction_id_ = transaction_id_++;
+        uint16_t length = pdu.size() + 1;
+        
+        std::vector<uint8_t> frame;
+        frame.reserve(7 + pdu.size());
+        frame.push_back(static_cast<uint8_t>((last_transaction_id_ >> 8) & 0xFF));
+        frame.push_back(static_cast<uint8_t>(last_transaction_id_ & 0xFF));
+        frame.push_back(0x00);
+        frame.push_back(0x00);
+        frame.push_back(static_cast<uint8_t>((length >> 8) & 0xFF));
+        frame.push_back(static_cast<uint8_t>(length & 0xFF));
+        frame.push_back(unit_id);
+        frame.insert(frame.end(), pdu.begin(), pdu.end());
+        return frame;
+    }
+
+    size_t expected_frame_length(const std::vector<uint8_t>& frame) const override {
+        if (frame.size() < 6) return 0;
+        return 6 + ((frame[4] << 8) | frame[5]);
+    }
+
+    bool decode_response(uint8_t unit_id, const std::vector<uint8_t>& frame,
+                         std::vector<uint8_t>& pdu, std::string& error) override {
+        if (frame.size() < 9) {
+            error = "Response too short";
+            return false;
+        }
+        
+        uint16_t transaction_id = (frame[0] << 8) | frame[1];
+        if (transaction_id != last_transaction_id_) {
+            error = "Transaction ID mismatch";
+            return false;
+        }
+        
+        if (frame[2] != 0x00 || frame[3] != 0x00) {
+            error = "Invalid protocol ID";
+            return false;
+        }
+        
+        if (frame[6] != unit_id) {
+            error = "Unexpected unit ID";
+            return false;
+        }
+        
+        size_t length = expected_frame_length(frame);
+        if (frame.size() < length) {
+            error = "Incomplete response";
+            return false;
+        }
+        
+        pdu.assign(frame.begin() + 7, frame.begin() + length);
+        return true;
+    }
+
+private:
+    uint16_t transaction_id_ = 1;
+    uint16_t last_transaction_id_ = 0;
+};
+
+// RTU framing carried over TCP, for serial-to-Ethernet converters in transparent mode
+class RtuOverTcpTransport : public ModbusTransport {
+public:
+    explicit RtuOverTcpTransport(uint32_t baud_rate) {
+        // 3.5 character times of 11 bits; fixed 1.75ms above 19200 baud per the RTU spec
+        if (baud_rate > 19200 || baud_rate == 0) {
+            silent_interval_us_ = 1750;
+        } else {
+            silent_interval_us_ = 38500000UL / baud_rate;
+        }
+    }
+
+    const char *get_name() const override { return "RTU over TCP"; }
+
+    std::vector<uint8_t> encode_request(uint8_t unit_id, const std::vector<uint8_t>& pdu) override {
+        std::vector<uint8_t> frame;
+        frame.reserve(pdu.size() + 3);
+        frame.push_back(unit_id);
+        frame.insert(frame.end(), pdu.begin(), pdu.end());
+        
+        uint16_t crc = modbus_crc16(frame.data(), frame.size());
+        frame.push_back(static_cast<uint8_t>(crc & 0xFF));         // CRC is sent low byte first
+        frame.push_back(static_cast<uint8_t>((crc >> 8) & 0xFF));
+        return frame;
+    }
+
+    size_t expected_frame_length(const std::vector<uint8_t>& frame) const override {
+        if (frame.size() < 2) return 0;
+        size_t pdu_length = modbus_response_pdu_length(frame.data() + 1, frame.size() - 1);
+        if (pdu_length == 0 || pdu_length == FRAME_LENGTH_UNKNOWN) return pdu_length;
+        return 1 + pdu_length + 2;
+    }
+
+    bool decode_response(uint8_t unit_id, const std::vector<uint8_t>& frame,
+                         std::vector<uint8_t>& pdu, std::string& error) override {
+        if (frame.size() < 4) {
+            error = "Response too short";
+            return false;
+        }
+        
+        size_t length = expected_frame_length(frame);
+        if (length == FRAME_LENGTH_UNKNOWN) {
+            length = frame.size();  // Unknown function code, frame was delimited by the silent interval
+        } else if (length == 0 || frame.size() < length) {
+            error = "Incomplete response";
+            return false;
+        }
+        
+        uint16_t crc = modbus_crc16(frame.data(), length - 2);
+        uint16_t received_crc = frame[length - 2] | (frame[length - 1] << 8);
+        if (crc != received_crc) {
+            error = "CRC mismatch";
+            return false;
+        }
+        
+        if (frame[0] != unit_id) {
+            error = "Unexpected unit ID";
+            return false;
+        }
+        
+        pdu.assign(frame.begin() + 1, frame.begin() + length - 2);
+        return true;
+    }
+
+    // Converters forward serial bytes as they arrive, so allow TCP jitter on top of t3.5
+    uint32_t get_frame_gap_ms() const override {
+        return (silent_interval_us_ + 999) / 1000 + 20;
+    }
+
+    // Keep the serial line quiet for t3.5 between our last response and the next request
+    void before_send() override {
+        if (last_frame_end_us_ == 0) return;
+        uint32_t elapsed = micros() - last_frame_end_us_;
+        if (elapsed < silent_interval_us_) {
+            delayMicroseconds(silent_interval_us_ - elapsed);
+        }
+    }
+
+    void after_receive() override {
+        last_frame_end_us_ = micros();
+    }
+
+    uint32_t get_silent_interval_us() const { return silent_interval_us_; }
+
+private:
+    uint32_t silent_interval_us_;
+    uint32_t last_frame_end_us_ = 0;
+};
+
+}  // namespace modbus_tcp
+}  // namespace esphome
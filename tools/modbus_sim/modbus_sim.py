@@ -0,0 +1,578 @@
+#!/usr/bin/env python3
+"""Scriptable Modbus TCP stand-in for testing modbus_tcp_manager against bad links.
+
+Serves a small register bank over Modbus TCP (MBAP) or RTU over TCP and injects
+network faults described by a scenario file: latency, jitter, segmented
+responses, mid-response resets, dropped replies, exception replies and
+refused connections. Every transaction can be recorded to a trace and replayed
+later with identical responses, delays and faults.
+
+Fault decisions are drawn from a random generator seeded with the scenario seed
+and the transaction number. Phases triggered by at_txn are therefore fully
+reproducible; phases triggered by at_s depend on when requests arrive. The
+scenario clock starts at the first accepted connection, so device start-up
+(including an esphome compile) is not counted.
+
+Typical use, running the component on the ESPHome host platform:
+
+    ./modbus_sim.py --scenario scenarios/flaky_wifi.json --record flaky.jsonl \\
+        --summary flaky.json --device-cmd "esphome run host_example.yaml"
+
+    ./modbus_sim.py --replay flaky.jsonl --baseline flaky.json \\
+        --device-cmd "esphome run host_example.yaml"
+
+A replay serves the recorded transactions and stops once the trace is used up.
+Requests are matched to recorded entries within a look-ahead window, so an
+extra or missing request does not shift every later fault.
+
+The summary reports throughput, recovery time after faults and, when
+--device-cmd is given, the loop stall and recovery times logged by the
+component. With --baseline the run fails if any of them regressed.
+"""
+
+import argparse
+import asyncio
+import json
+import random
+import re
+import shlex
+import socket
+import struct
+import sys
+import time
+
+# Phase settings; a phase replaces all settings of the previous one
+PHASE_DEFAULTS = {
+    "latency_ms": 0,
+    "jitter_ms": 0,
+    "segment_bytes": 0,
+    "segment_gap_ms": 0,
+    "drop_rate": 0.0,
+    "reset_rate": 0.0,
+    "exception_rate": 0.0,
+    "exception_code": 4,
+    "offline": False,
+}
+
+# Metrics compared against a baseline, and whether higher values are better
+BASELINE_METRICS = {
+    "throughput_tps": True,
+    "recovery_ms.max": False,
+    "max_success_gap_ms": False,
+    "divergences": False,
+    "device.loop_stall_max_ms": False,
+    "device.recovery_max_ms": False,
+}
+
+PERF_RE = re.compile(r"Perf: (\d+) transactions, (\d+) failed, loop stall max (\d+) ms, recovery max (\d+) ms")
+RESTORED_RE = re.compile(r"connection restored to .* after (\d+) ms")
+
+
+def _crc_table():
+    table = []
+    for i in range(256):
+        crc = i
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+        table.append(crc)
+    return table
+
+
+CRC16_TABLE = _crc_table()
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc = (crc >> 8) ^ CRC16_TABLE[(crc ^ byte) & 0xFF]
+    return crc
+
+
+class MbapFraming:
+    name = "tcp"
+
+    async def read_request(self, reader):
+        header = await reader.readexactly(7)
+        tid, proto, length, unit = struct.unpack(">HHHB", header)
+        pdu = await reader.readexactly(length - 1)
+        return {"tid": tid, "proto": proto, "unit": unit}, pdu
+
+    def encode_response(self, context, pdu):
+        return struct.pack(">HHHB", context["tid"], context["proto"], len(pdu) + 1, context["unit"]) + pdu
+
+
+class RtuFraming:
+    name = "rtu_over_tcp"
+
+    async def read_request(self, reader):
+        head = await reader.readexactly(2)
+        function = head[1]
+        if function in (0x0F, 0x10):
+            rest = await reader.readexactly(5)
+            rest += await reader.readexactly(rest[4] + 2)
+        else:
+            rest = await reader.readexactly(6)
+        frame = head + rest
+        if crc16(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+            raise ValueError("CRC mismatch in request")
+        return {"unit": frame[0]}, frame[1:-2]
+
+    def encode_response(self, context, pdu):
+        frame = bytes([context["unit"]]) + pdu
+        return frame + struct.pack("<H", crc16(frame))
+
+
+FRAMINGS = {"tcp": MbapFraming, "rtu_over_tcp": RtuFraming}
+
+
+class RegisterBank:
+    def __init__(self, config):
+        self.holding = {int(k): v & 0xFFFF for k, v in config.get("holding", {}).items()}
+        self.input = {int(k): v & 0xFFFF for k, v in config.get("input", {}).items()}
+        # Registers the "device" increments after every write, like a watchdog counter
+        self.auto_increment = set(config.get("auto_increment", []))
+
+    def handle(self, pdu):
+        function = pdu[0]
+        if function in (0x03, 0x04) and len(pdu) >= 5:
+            address, count = struct.unpack(">HH", pdu[1:5])
+            table = self.holding if function == 0x03 else self.input
+            values = [table.get(address + i, 0) for i in range(count)]
+            return bytes([function, count * 2]) + struct.pack(">%dH" % count, *values)
+        if function == 0x06 and len(pdu) >= 5:
+            address, value = struct.unpack(">HH", pdu[1:5])
+            self._write(address, value)
+            return pdu[:5]
+        if function == 0x10 and len(pdu) >= 6:
+            address, count = struct.unpack(">HH", pdu[1:5])
+            values = struct.unpack(">%dH" % count, pdu[6:6 + count * 2])
+            for i, value in enumerate(values):
+                self._write(address + i, value)
+            return pdu[:5]
+        return bytes([function | 0x80, 0x01])  # Illegal function
+
+    def _write(self, address, value):
+        if address in self.auto_increment:
+            value = (value + 1) & 0xFFFF
+        self.holding[address] = value
+
+
+class Scenario:
+    def __init__(self, config):
+        self.seed = config.get("seed", 0)
+        self.transport = config.get("transport", "tcp")
+        self.duration_s = config.get("duration_s", 60)
+        self.bank = RegisterBank(config.get("registers", {}))
+        self.phases = config.get("phases", [])
+
+    def settings(self, elapsed_s, txn):
+        """Settings of the last phase whose at_s or at_txn trigger has passed."""
+        active = {}
+        for phase in self.phases:
+            if elapsed_s >= phase.get("at_s", float("inf")) or txn >= phase.get("at_txn", float("inf")):
+                active = phase
+        settings = dict(PHASE_DEFAULTS)
+        settings.update({k: v for k, v in active.items() if k in PHASE_DEFAULTS})
+        return settings
+
+    def rng(self, txn):
+        return random.Random("%s:%d" % (self.seed, txn))
+
+    def plan(self, elapsed_s, txn):
+        """Fault plan for one transaction. Draw order is fixed to keep runs reproducible."""
+        settings = self.settings(elapsed_s, txn)
+        rng = self.rng(txn)
+        drop, reset, exception, jitter = rng.random(), rng.random(), rng.random(), rng.random()
+        fault = None
+        if drop < settings["drop_rate"]:
+            fault = "drop"
+        elif reset < settings["reset_rate"]:
+            fault = "reset"
+        elif exception < settings["exception_rate"]:
+            fault = "exception"
+        return {
+            "fault": fault,
+            "exception_code": settings["exception_code"],
+            "delay_ms": settings["latency_ms"] + int(jitter * settings["jitter_ms"]),
+            "segment_bytes": settings["segment_bytes"],
+            "segment_gap_ms": settings["segment_gap_ms"],
+        }
+
+
+class Replay:
+    def __init__(self, path, window):
+        with open(path) as f:
+            lines = [json.loads(line) for line in f if line.strip()]
+        self.meta = lines[0].get("meta", {}) if lines and "meta" in lines[0] else {}
+        self.entries = [line for line in lines if "txn" in line]
+        self.position = 0
+        self.window = window
+        self.stats = {"exact": 0, "loose": 0, "unmatched": 0, "skipped": 0}
+
+    def exhausted(self):
+        return self.position >= len(self.entries)
+
+    def next(self):
+        if self.position >= len(self.entries):
+            return None
+        entry = self.entries[self.position]
+        self.position += 1
+        return entry
+
+    def peek_offline(self):
+        return self.position < len(self.entries) and self.entries[self.position]["fault"] == "offline"
+
+    def match(self, request):
+        """Find the recorded entry for a request within the look-ahead window.
+
+        An exact byte match wins; otherwise the first entry with the same function
+        code and address is used, so e.g. a write of a different value still gets
+        the recorded fault. Recorded entries passed over are counted as skipped.
+        A request with no match leaves the position alone, so the trace picks up
+        again with the next request that does match.
+        """
+        end = min(self.position + self.window, len(self.entries))
+        candidates = [i for i in range(self.position, end) if self.entries[i]["request"] is not None]
+        request_hex = request.hex()
+        index = next((i for i in candidates if self.entries[i]["request"] == request_hex), None)
+        kind = "exact"
+        if index is None:
+            index = next((i for i in candidates if self.entries[i]["request"][:6] == request_hex[:6]), None)
+            kind = "loose"
+        if index is None:
+            self.stats["unmatched"] += 1
+            return None, None
+        self.stats["skipped"] += index - self.position
+        self.stats[kind] += 1
+        self.position = index + 1
+        return self.entries[index], kind
+
+    def divergences(self):
+        # Loose matches still reproduce the recorded fault, so they are not divergences
+        return self.stats["unmatched"] + self.stats["skipped"]
+
+
+class Metrics:
+    def __init__(self):
+        self.start = None  # Set by begin() on the first accepted connection
+        self.transactions = 0
+        self.ok = 0
+        self.faults = {}
+        self.divergences = 0
+        self.recoveries = []
+        self.max_success_gap_ms = 0
+        self.last_success = None
+        self.last_failure = None
+        self.device = {}
+
+    def begin(self):
+        if self.start is None:
+            self.start = time.monotonic()
+
+    def elapsed_s(self):
+        return time.monotonic() - self.start if self.start is not None else 0.0
+
+    def now_ms(self):
+        return int(self.elapsed_s() * 1000)
+
+    def success(self):
+        now = self.now_ms()
+        self.ok += 1
+        if self.last_failure is not None:
+            self.recoveries.append(now - self.last_failure)
+            self.last_failure = None
+        gap = now - (self.last_success if self.last_success is not None else 0)
+        self.max_success_gap_ms = max(self.max_success_gap_ms, gap)
+        self.last_success = now
+
+    def failure(self, fault):
+        self.faults[fault] = self.faults.get(fault, 0) + 1
+        # Recovery is timed from the first failure of a streak, i.e. the start of the outage
+        if self.last_failure is None:
+            self.last_failure = self.now_ms()
+
+    def device_line(self, line):
+        match = PERF_RE.search(line)
+        if match:
+            transactions, failed, stall, recovery = (int(g) for g in match.groups())
+            self.device["transactions"] = transactions
+            self.device["failed"] = failed
+            self.device["loop_stall_max_ms"] = max(self.device.get("loop_stall_max_ms", 0), stall)
+            self.device["recovery_max_ms"] = max(self.device.get("recovery_max_ms", 0), recovery)
+        match = RESTORED_RE.search(line)
+        if match:
+            self.device["recovery_max_ms"] = max(self.device.get("recovery_max_ms", 0), int(match.group(1)))
+
+    def summary(self):
+        elapsed_s = self.elapsed_s()
+        recoveries = self.recoveries or [0]
+        return {
+            "duration_s": round(elapsed_s, 1),
+            "transactions": self.transactions,
+            "ok": self.ok,
+            "faults": self.faults,
+            "throughput_tps": round(self.ok / elapsed_s, 3) if elapsed_s > 0 else 0,
+            "recovery_ms": {
+                "count": len(self.recoveries),
+                "avg": int(sum(recoveries) / len(recoveries)),
+                "max": max(recoveries),
+            },
+            "max_success_gap_ms": self.max_success_gap_ms,
+            "divergences": self.divergences,
+            "device": self.device,
+        }
+
+
+class Simulator:
+    def __init__(self, scenario, framing, record=None, replay=None):
+        self.scenario = scenario
+        self.framing = framing
+        self.record = record
+        self.replay = replay
+        self.metrics = Metrics()
+        self.started = asyncio.Event()
+        self.finished = asyncio.Event()
+
+    def elapsed_s(self):
+        return self.metrics.elapsed_s()
+
+    def next_txn(self):
+        txn = self.metrics.transactions
+        self.metrics.transactions += 1
+        return txn
+
+    def log(self, entry):
+        if self.record:
+            self.record.write(json.dumps(entry) + "\n")
+            self.record.flush()
+
+    async def handle_client(self, reader, writer):
+        self.metrics.begin()
+        self.started.set()
+        try:
+            while True:
+                if self.is_offline():
+                    txn = self.next_txn()
+                    if self.replay:
+                        self.replay.next()
+                    self.log({"txn": txn, "t_ms": self.metrics.now_ms(), "request": None,
+                              "response": None, "fault": "offline"})
+                    self.metrics.failure("offline")
+                    reset(writer)
+                    return
+
+                context, request = await self.framing.read_request(reader)
+                txn = self.next_txn()
+                plan, response = self.respond(txn, request)
+                self.log({"txn": txn, "t_ms": self.metrics.now_ms(), "request": request.hex(),
+                          "response": response.hex() if response is not None else None, **plan})
+
+                if plan["delay_ms"]:
+                    await asyncio.sleep(plan["delay_ms"] / 1000)
+
+                if plan["fault"] == "drop":
+                    self.metrics.failure("drop")
+                    await reader.read()  # Hold the connection until the client gives up
+                    return
+
+                frame = self.framing.encode_response(context, response)
+                if plan["fault"] == "reset":
+                    writer.write(frame[:len(frame) // 2])
+                    await writer.drain()
+                    self.metrics.failure("reset")
+                    reset(writer)
+                    return
+
+                await send_segmented(writer, frame, plan["segment_bytes"], plan["segment_gap_ms"])
+                if plan["fault"] == "exception":
+                    self.metrics.failure("exception")
+                else:
+                    self.metrics.success()
+        except (asyncio.IncompleteReadError, ConnectionError, ValueError):
+            pass
+        finally:
+            writer.close()
+            if self.replay and self.replay.exhausted():
+                self.finished.set()
+
+    def is_offline(self):
+        if self.replay:
+            return self.replay.peek_offline()
+        return self.scenario.settings(self.elapsed_s(), self.metrics.transactions)["offline"]
+
+    def respond(self, txn, request):
+        if self.replay:
+            entry, kind = self.replay.match(request)
+            self.metrics.divergences = self.replay.divergences()
+            if entry is None:
+                print("Replay: no recorded match for transaction %d (%s)" % (txn, request.hex()), file=sys.stderr)
+                plan = {"fault": None, "delay_ms": 0, "segment_bytes": 0, "segment_gap_ms": 0}
+                return plan, self.scenario.bank.handle(request)
+            plan = {k: entry.get(k, 0) for k in ("fault", "delay_ms", "segment_bytes", "segment_gap_ms")}
+            if kind == "exact" or plan["fault"] == "exception":
+                response = bytes.fromhex(entry["response"]) if entry["response"] else b""
+            else:
+                response = self.scenario.bank.handle(request)  # Recorded reply would echo other values
+            return plan, response
+
+        plan = self.scenario.plan(self.elapsed_s(), txn)
+        if plan["fault"] == "exception":
+            response = bytes([request[0] | 0x80, plan["exception_code"]])
+        else:
+            response = self.scenario.bank.handle(request)
+        plan.pop("exception_code", None)
+        return plan, response
+
+
+def reset(writer):
+    """Close with an RST instead of a FIN, like a crashing gateway."""
+    sock = writer.get_extra_info("socket")
+    if sock is not None:
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+    writer.transport.abort()
+
+
+async def send_segmented(writer, frame, segment_bytes, segment_gap_ms):
+    if segment_bytes <= 0:
+        writer.write(frame)
+        await writer.drain()
+        return
+    for offset in range(0, len(frame), segment_bytes):
+        writer.write(frame[offset:offset + segment_bytes])
+        await writer.drain()
+        if offset + segment_bytes < len(frame) and segment_gap_ms:
+            await asyncio.sleep(segment_gap_ms / 1000)
+
+
+async def run_device(command, metrics, echo):
+    process = await asyncio.create_subprocess_exec(
+        *shlex.split(command), stdout=asyncio.subprocess.PIPE, stderr=asyncio.subprocess.STDOUT)
+    try:
+        while True:
+            line = await process.stdout.readline()
+            if not line:
+                break
+            text = line.decode(errors="replace").rstrip()
+            if echo:
+                print(text, file=sys.stderr)
+            metrics.device_line(text)
+    finally:
+        if process.returncode is None:
+            process.terminate()
+            await process.wait()
+
+
+def lookup(summary, path):
+    value = summary
+    for key in path.split("."):
+        if not isinstance(value, dict) or key not in value:
+            return None
+        value = value[key]
+    return value
+
+
+def compare(summary, baseline, tolerance, min_delta_ms):
+    regressions = []
+    for path, higher_is_better in BASELINE_METRICS.items():
+        current, previous = lookup(summary, path), lookup(baseline, path)
+        if current is None or previous is None:
+            continue
+        # Timing metrics also need an absolute change, so scheduling noise on tiny values passes
+        if path.endswith("_ms") and abs(current - previous) < min_delta_ms:
+            continue
+        if higher_is_better and current < previous * (1 - tolerance):
+            regressions.append("%s dropped from %s to %s" % (path, previous, current))
+        elif not higher_is_better and current > previous * (1 + tolerance) and current > previous:
+            regressions.append("%s rose from %s to %s" % (path, previous, current))
+    return regressions
+
+
+async def main_async(args):
+    config = {}
+    if args.scenario:
+        with open(args.scenario) as f:
+            config = json.load(f)
+    replay = Replay(args.replay, args.replay_window) if args.replay else None
+    if replay:
+        config = {**replay.meta, **config}
+    if args.transport:
+        config["transport"] = args.transport
+
+    scenario = Scenario(config)
+    framing = FRAMINGS[scenario.transport]()
+    scenario_duration_s = args.duration or scenario.duration_s
+    duration_s = scenario_duration_s
+    if replay and not args.duration:
+        # Replays end when the trace is used up; the timer only guards against a stalled device
+        duration_s = scenario_duration_s * 2
+
+    record = open(args.record, "w") if args.record else None
+    if record:
+        record.write(json.dumps({"meta": {"seed": scenario.seed, "transport": scenario.transport,
+                                          "duration_s": scenario_duration_s,
+                                          "registers": config.get("registers", {})}}) + "\n")
+
+    simulator = Simulator(scenario, framing, record, replay)
+    server = await asyncio.start_server(simulator.handle_client, args.host, args.port)
+    print("Serving %s on %s:%d, %ds from first connection" % (framing.name, args.host, args.port, duration_s),
+          file=sys.stderr)
+
+    async def run_timer():
+        await simulator.started.wait()
+        await asyncio.sleep(duration_s)
+
+    tasks = [asyncio.ensure_future(run_timer()), asyncio.ensure_future(simulator.finished.wait())]
+    if args.device_cmd:
+        tasks.append(asyncio.ensure_future(run_device(args.device_cmd, simulator.metrics, args.device_log)))
+    await asyncio.wait(tasks, return_when=asyncio.FIRST_COMPLETED)
+    for task in tasks:
+        task.cancel()
+    await asyncio.gather(*tasks, return_exceptions=True)
+
+    server.close()
+    await server.wait_closed()
+    if record:
+        record.close()
+    summary = simulator.metrics.summary()
+    if replay:
+        summary["replay"] = dict(replay.stats, unreplayed=len(replay.entries) - replay.position)
+    return summary
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--scenario", help="Scenario JSON file (registers, seed, fault phases)")
+    parser.add_argument("--replay", help="Replay a recorded trace instead of drawing faults")
+    parser.add_argument("--record", help="Write a transaction trace (JSON lines)")
+    parser.add_argument("--summary", help="Write the run summary as JSON")
+    parser.add_argument("--baseline", help="Fail if the summary regressed against this earlier summary")
+    parser.add_argument("--tolerance", type=float, default=0.2, help="Allowed relative regression (default 0.2)")
+    parser.add_argument("--min-delta-ms", type=int, default=250,
+                        help="Smallest change in a timing metric that counts as a regression (default 250)")
+    parser.add_argument("--replay-window", type=int, default=16,
+                        help="How many recorded transactions to look ahead when matching a request (default 16)")
+    parser.add_argument("--device-cmd", help="Command running the component, e.g. 'esphome run host_example.yaml'")
+    parser.add_argument("--device-log", action="store_true", help="Echo the device output to stderr")
+    parser.add_argument("--transport", choices=sorted(FRAMINGS), help="Override the scenario transport")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=5020)
+    parser.add_argument("--duration", type=float, help="Override the scenario duration in seconds")
+    args = parser.parse_args()
+
+    summary = asyncio.run(main_async(args))
+    print(json.dumps(summary, indent=2))
+    if args.summary:
+        with open(args.summary, "w") as f:
+            json.dump(summary, f, indent=2)
+
+    if args.baseline:
+        with open(args.baseline) as f:
+            regressions = compare(summary, json.load(f), args.tolerance, args.min_delta_ms)
+        for regression in regressions:
+            print("REGRESSION: " + regression, file=sys.stderr)
+        if regressions:
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()